@@ -14,4 +14,6 @@ LOCK_SCRAP=true
 LOCK_BIDIRECTIONAL=true
 ; Lock items when Take All Items is used
 LOCK_TAKEALL=true
+; Lock equipped and/or favorite inventory items from dropping
+LOCK_DROP=true
 )";
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <PCH.h>
+#include <LockPolicy.h>
 #include <Plugin.h>
 
 // Global logger pointer
@@ -20,18 +21,25 @@ extern const char* defaultIni;
 
 // Global module name
 extern std::string g_moduleName;
+// Runtime this build targets, resolved once from the module name (indexes the address table)
+enum class Runtime : std::size_t
+{
+    kOG = 0, // 1.10.163
+    kNG,
+    kAE,
+    kTotal
+};
+extern Runtime g_runtime;
+inline Runtime ResolveRuntime(std::string_view a_moduleName) {
+    if (a_moduleName == "InvLockerCLXAE")
+        return Runtime::kAE;
+    if (a_moduleName == "InvLockerCLX")
+        return Runtime::kNG;
+    return Runtime::kOG;
+}
 // Global debug flag
-extern bool DEBUGGING;
-// Lock equipped inventory items
-extern bool LOCK_EQUIPPED;
-// Lock favorite inventory items
-extern bool LOCK_FAVORITES;
-// Lock scrapping of equipped and/or favorite inventory items
-extern bool LOCK_SCRAP;
-// Bi-directional locking
-extern bool LOCK_BIDIRECTIONAL;
-// Lock when using Take All Items
-extern bool LOCK_TAKEALL;
+extern std::atomic<bool> DEBUGGING;
+
 
 // Helper function to convert string to lowercase
 inline std::string ToLower(const std::string& str) {
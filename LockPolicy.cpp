@@ -0,0 +1,30 @@
+#include <PCH.h>
+#include <LockPolicy.h>
+
+// Packed LockPolicy bits
+enum LockPolicyBits : std::uint32_t
+{
+    kEquipped = 1u << 0,
+    kFavorites = 1u << 1,
+    kScrap = 1u << 2,
+    kBidirectional = 1u << 3,
+    kTakeAll = 1u << 4,
+    kDrop = 1u << 5,
+};
+
+static std::uint32_t Pack(const LockPolicy& a_policy) {
+    return (a_policy.equipped ? kEquipped : 0u) | (a_policy.favorites ? kFavorites : 0u) | (a_policy.scrap ? kScrap : 0u) |
+           (a_policy.bidirectional ? kBidirectional : 0u) | (a_policy.takeAll ? kTakeAll : 0u) | (a_policy.drop ? kDrop : 0u);
+}
+
+static std::atomic<std::uint32_t> g_lockPolicy{ Pack(LockPolicy{}) };
+
+LockPolicy GetLockPolicy() {
+    const auto bits = g_lockPolicy.load(std::memory_order_acquire);
+    return { (bits & kEquipped) != 0, (bits & kFavorites) != 0, (bits & kScrap) != 0, (bits & kBidirectional) != 0, (bits & kTakeAll) != 0,
+             (bits & kDrop) != 0 };
+}
+
+void SetLockPolicy(const LockPolicy& a_policy) {
+    g_lockPolicy.store(Pack(a_policy), std::memory_order_release);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <PCH.h>
+
+// Lock configuration. Hooks, Papyrus threads and config reloads share it, so it is published
+// as one packed atomic word: a reader always gets a complete snapshot, never half of a reload.
+struct LockPolicy
+{
+    // Lock equipped inventory items
+    bool equipped = true;
+    // Lock favorite inventory items
+    bool favorites = true;
+    // Lock scrapping of equipped and/or favorite inventory items
+    bool scrap = true;
+    // Bi-directional locking
+    bool bidirectional = true;
+    // Lock when using Take All Items
+    bool takeAll = true;
+    // Lock dropping of equipped and/or favorite inventory items
+    bool drop = true;
+
+    bool LocksAnything() const { return equipped || favorites; }
+};
+LockPolicy GetLockPolicy();
+void SetLockPolicy(const LockPolicy& a_policy);
@@ -0,0 +1,52 @@
+#include <Global.h>
+#include <MenuArena.h>
+
+MenuArena& MenuArena::GetSingleton() {
+    static MenuArena singleton;
+    return singleton;
+}
+
+std::pmr::memory_resource* MenuArena::Begin(std::size_t a_entryCount) {
+    if (_arena)
+        return &_tracker;
+    // Size from the entry count, grow the kept buffer only if this menu needs more
+    const std::size_t capacity = (std::max)(a_entryCount * BYTES_PER_ENTRY, MIN_CAPACITY);
+    if (_buffer.size() < capacity)
+        _buffer.resize(capacity);
+    // Overflow falls back to the general heap and is still released on Release()
+    _arena.emplace(_buffer.data(), _buffer.size(), std::pmr::new_delete_resource());
+    _tracker.upstream = &*_arena;
+    _tracker.used = 0;
+    ++_sessions;
+    if (DEBUGGING)
+        REX::INFO("MenuArena: Session {} started for {} entries ({} bytes)", _sessions, a_entryCount, _buffer.size());
+    return &_tracker;
+}
+
+std::pmr::memory_resource* MenuArena::Resource() {
+    return _arena ? &_tracker : nullptr;
+}
+
+void MenuArena::Release() {
+    if (!_arena)
+        return;
+    // Report a new high-water mark so large stashes show up in the log
+    if (_tracker.used > _highWater) {
+        _highWater = _tracker.used;
+        REX::INFO("MenuArena: New high-water mark {} bytes (capacity {} bytes, sessions {})", _highWater, _buffer.size(), _sessions);
+    } else if (DEBUGGING) {
+        REX::INFO("MenuArena: Session {} released, used {} bytes (high-water {} bytes)", _sessions, _tracker.used, _highWater);
+    }
+    _tracker.upstream = nullptr;
+    _tracker.used = 0;
+    _arena.reset();
+}
+
+void* MenuArena::Tracker::do_allocate(std::size_t a_bytes, std::size_t a_align) {
+    used += a_bytes;
+    return upstream->allocate(a_bytes, a_align);
+}
+
+void MenuArena::Tracker::do_deallocate(void*, std::size_t, std::size_t) {
+    // Monotonic: memory only goes away on Release(), so a container destroyed after it does not touch the freed arena
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <PCH.h>
+
+// --- Menu session arena ---
+// Bump allocator for transient data built while a menu is open (the container stacks
+// TakeAllItems judged locked before its transfer loop).
+// Use it through std::pmr containers; everything is released at once when the menu closes.
+// The backing buffer is kept between sessions and only grows, so opening a menu does not churn the game heap.
+// Only touched from the UI thread.
+class MenuArena
+{
+public:
+    // Rough per-entry budget for a reserved std::pmr::unordered_set<std::uint64_t>: one 24-byte node
+    // plus up to two buckets of two pointers each (bucket counts round up to a power of two)
+    static constexpr std::size_t BYTES_PER_ENTRY = 64;
+    static constexpr std::size_t MIN_CAPACITY = 4 * 1024;
+
+    static MenuArena& GetSingleton();
+
+    // Start a session sized for a_entryCount inventory entries (returns the active resource if already started)
+    std::pmr::memory_resource* Begin(std::size_t a_entryCount);
+    // Resource of the active session, nullptr if no session is open
+    std::pmr::memory_resource* Resource();
+    // Drop everything allocated during the session
+    void Release();
+
+    bool IsActive() const { return _arena.has_value(); }
+    std::size_t GetCapacity() const { return _buffer.size(); }
+    std::size_t GetUsed() const { return _tracker.used; }
+    std::size_t GetHighWater() const { return _highWater; }
+    std::size_t GetSessions() const { return _sessions; }
+
+private:
+    // Counts the bytes handed out by the monotonic resource (deallocate is a no-op there)
+    class Tracker : public std::pmr::memory_resource
+    {
+    public:
+        std::pmr::memory_resource* upstream = nullptr;
+        std::size_t used = 0;
+
+    private:
+        void* do_allocate(std::size_t a_bytes, std::size_t a_align) override;
+        void do_deallocate(void* a_ptr, std::size_t a_bytes, std::size_t a_align) override;
+        bool do_is_equal(const std::pmr::memory_resource& a_other) const noexcept override { return this == &a_other; }
+    };
+
+    MenuArena() = default;
+
+    std::vector<std::byte> _buffer;
+    std::optional<std::pmr::monotonic_buffer_resource> _arena;
+    Tracker _tracker;
+    std::size_t _highWater = 0;
+    std::size_t _sessions = 0;
+};
+
+// Container stacks TakeAllItems judged locked, allocated in the menu arena.
+// Keyed by (inventory handle, stack id) like CheckEquippedOrFavorite judges an entry,
+// so the other stacks of a locked item are still taken.
+class LockedStacks
+{
+public:
+    LockedStacks(std::pmr::memory_resource* a_resource, std::size_t a_entries) : _stacks(a_resource) { _stacks.reserve(a_entries); }
+
+    void Insert(std::uint32_t a_handle, std::uint32_t a_stackId) { _stacks.insert(MakeKey(a_handle, a_stackId)); }
+    bool Contains(std::uint32_t a_handle, std::uint32_t a_stackId) const { return _stacks.contains(MakeKey(a_handle, a_stackId)); }
+
+private:
+    static std::uint64_t MakeKey(std::uint32_t a_handle, std::uint32_t a_stackId) { return (static_cast<std::uint64_t>(a_handle) << 32) | a_stackId; }
+
+    std::pmr::unordered_set<std::uint64_t> _stacks;
+};
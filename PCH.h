@@ -26,21 +26,26 @@ using namespace std::literals;
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory_resource>
+#include <mutex>
 #include <new>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 #include <windows.h>
+#include <psapi.h>
 
 // --- Fixes ---
 // STD FORMATTER RE::BSFixedString
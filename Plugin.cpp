@@ -1,8 +1,11 @@
 #include <Global.h>
 #include <PCH.h>
+#include <MenuArena.h>
+#include <ProtectionService.h>
+#include <Startup.h>
 
 // Helper to check the entry
-bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::InventoryUserUIInterfaceEntry* a_entry) {
+bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::InventoryUserUIInterfaceEntry* a_entry, const LockPolicy& a_policy) {
     // Start checking items
     bool bIsEquipped = false;
     bool bIsFavorite = false;
@@ -13,12 +16,14 @@ bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::
             std::uint32_t stackId = 0; bool haveStackId = false;
             if (!a_entry->stackIndex.empty()) { stackId = static_cast<std::uint32_t>(a_entry->stackIndex[0]); haveStackId = true; }
             if (haveStackId) {
-                if (IsItemEquipped(invItem, stackId)) {
+                // Shared with the other hooks through the protection service
+                const auto facts = ProtectionService::GetSingleton().GetFacts(invItem, stackId);
+                if (facts.equipped) {
                     if (DEBUGGING)
                         REX::INFO("CheckEquippedOrFavorite: Item (handle {}) is equipped (stackId {})", a_entry->invHandle.id, stackId);
                     bIsEquipped = true;
                 }
-                if (IsItemFavorite(invItem, stackId)) {
+                if (facts.favorite) {
                     if (DEBUGGING)
                         REX::INFO("CheckEquippedOrFavorite: Item (handle {}) is favorite (stackId {})", a_entry->invHandle.id, stackId);
                     bIsFavorite = true;
@@ -30,7 +35,7 @@ bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::
             }
         }
     }
-    return ( (LOCK_EQUIPPED && bIsEquipped) || (LOCK_FAVORITES && bIsFavorite) );
+    return ( (a_policy.equipped && bIsEquipped) || (a_policy.favorites && bIsFavorite) );
 }
 
 // Helper to check if the item is equipped
@@ -62,8 +67,10 @@ ContDoItemTransfer_t *_originalContDoItemTransfer = nullptr;
 void MyContDoItemTransfer(RE::ContainerMenu* menu, std::uint32_t a_itemIndex, std::uint32_t a_count, bool a_fromContainer) {
     if (DEBUGGING)
         REX::INFO("MyContDoItemTransfer: Attempting to transfer item at index {} (count: {}) from container: {}", a_itemIndex, a_count, a_fromContainer);
+    // One policy snapshot for the whole decision
+    const auto policy = GetLockPolicy();
     // Early exit if conditions to lock are not met
-    if ((!LOCK_EQUIPPED && !LOCK_FAVORITES) || (a_fromContainer && !LOCK_BIDIRECTIONAL)) {
+    if (!policy.LocksAnything() || (a_fromContainer && !policy.bidirectional)) {
         _originalContDoItemTransfer(menu, a_itemIndex, a_count, a_fromContainer);
         return;
     }
@@ -88,7 +95,7 @@ void MyContDoItemTransfer(RE::ContainerMenu* menu, std::uint32_t a_itemIndex, st
     // Check only one valid entry
     const auto* entry = entryPassed ? entryPassed : entryFlipped;
     // Check if the item is equipped or favorite
-    bool blocked = CheckEquippedOrFavorite(invInterface, entry);
+    bool blocked = CheckEquippedOrFavorite(invInterface, entry, policy);
     // If the item is blocked, prevent transfer
     if (blocked) {
         if (DEBUGGING)
@@ -104,8 +111,10 @@ BartDoItemTransfer_t *_originalBartDoItemTransfer = nullptr;
 void MyBartDoItemTransfer(RE::BarterMenu* menu, std::uint32_t a_itemIndex, std::uint32_t a_count, bool a_fromContainer) {
     if (DEBUGGING)
         REX::INFO("MyBartDoItemTransfer: function called for item index {}", a_itemIndex);
+    // One policy snapshot for the whole decision
+    const auto policy = GetLockPolicy();
     // Early exit if conditions to lock are not met
-    if ((!LOCK_EQUIPPED && !LOCK_FAVORITES) || (a_fromContainer && !LOCK_BIDIRECTIONAL)) {
+    if (!policy.LocksAnything() || (a_fromContainer && !policy.bidirectional)) {
         _originalBartDoItemTransfer(menu, a_itemIndex, a_count, a_fromContainer);
         return;
     }
@@ -123,7 +132,7 @@ void MyBartDoItemTransfer(RE::BarterMenu* menu, std::uint32_t a_itemIndex, std::
     // Check only one valid entry
     const auto* entry = entryPassed ? entryPassed : entryFlipped;
     // Check if the item is equipped or favorite
-    bool blocked = CheckEquippedOrFavorite(invInterface, entry);
+    bool blocked = CheckEquippedOrFavorite(invInterface, entry, policy);
     // If the item is blocked, prevent transfer
     if (blocked) {
         if (DEBUGGING)
@@ -138,8 +147,10 @@ ScrapOnAccept_t* _originalScrapOnAccept = nullptr;
 void MyScrapOnAccept(RE::ScrapItemCallback* self) {
     if (DEBUGGING)
         REX::INFO("MyScrapOnAccept: function called");
+    // One policy snapshot for the whole decision
+    const auto policy = GetLockPolicy();
     // Early exit if scrapping lock is disabled
-    if (!LOCK_SCRAP || (!LOCK_EQUIPPED && !LOCK_FAVORITES)) {
+    if (!policy.scrap || !policy.LocksAnything()) {
         _originalScrapOnAccept(self);
         return;
     }
@@ -164,7 +175,7 @@ void MyScrapOnAccept(RE::ScrapItemCallback* self) {
     // Get the InventoryItem for the scrapped item (make sure to use a pointer or equiped check will fail)
     const auto& entry = menu->invInterface.stackedEntries[index];
     // Check if the item is equipped or favorite
-    bool blocked = CheckEquippedOrFavorite(invInterface, &entry);
+    bool blocked = CheckEquippedOrFavorite(invInterface, &entry, policy);
     // If the item is blocked, prevent scrapping
     if (blocked) {
         if (DEBUGGING)
@@ -188,12 +199,29 @@ void MyTakeAllItems(RE::ContainerMenu* menu) {
         //_originalTakeAllItems(menu);
         return;
     }
+    // Judge the container entries once up front, same rules as MyContDoItemTransfer.
+    // Locked stacks live in the menu arena, released when the menu closes
+    const auto entryCount = menu->containerInv.stackedEntries.size();
+    const auto policy = GetLockPolicy();
+    const bool judge = policy.LocksAnything() && policy.bidirectional && !IsContainerDeadActor(menu);
+    LockedStacks lockedStacks{ MenuArena::GetSingleton().Begin(entryCount), judge ? entryCount : 0 };
+    if (judge) {
+        for (const auto& entry : menu->containerInv.stackedEntries) {
+            if (!entry.stackIndex.empty() && CheckEquippedOrFavorite(invInterface, &entry, policy))
+                lockedStacks.Insert(entry.invHandle.id, static_cast<std::uint32_t>(entry.stackIndex[0]));
+        }
+    }
     // Go over the inventory backwards to avoid index shifting indices issues
-    for (int i = static_cast<int>(menu->containerInv.stackedEntries.size()) - 1; i >= 0; --i) {
+    for (int i = static_cast<int>(entryCount) - 1; i >= 0; --i) {
+        // A transfer may remove several list entries, re-check the index against the updated list
+        if (static_cast<std::size_t>(i) >= menu->containerInv.stackedEntries.size())
+            continue;
         const auto& entry = menu->containerInv.stackedEntries[i];
         if (entry.invHandle.id == 0xFFFFFFFFu || entry.stackIndex.empty())
             continue;
-        if (entry.stackIndex.empty())
+        // Skip locked stacks, saves the transfer attempt and the list update. Stack ids shift when stacks
+        // are removed, so a key match is re-checked against the current entry before it is skipped
+        if (lockedStacks.Contains(entry.invHandle.id, static_cast<std::uint32_t>(entry.stackIndex[0])) && CheckEquippedOrFavorite(invInterface, &entry, policy))
             continue;
         // Check if we get a valis InventoryItem at this index to get the count
         auto* invItem = invInterface->RequestInventoryItem(entry.invHandle.id);
@@ -213,59 +241,185 @@ void MyTakeAllItems(RE::ContainerMenu* menu) {
     REX::INFO("MyTakeAllItems: function funinished, total items attempted to transfer: {}", counter);
 }
 
+// Replace the player's TESObjectREFR::RemoveItem to guard Pip-Boy drops.
+// ObjectRefHandle is returned by value, MSVC passes it as a hidden result pointer after this.
+using RemoveItem_t = RE::ObjectRefHandle*(RE::TESObjectREFR*, RE::ObjectRefHandle*, RE::TESObjectREFR::RemoveItemData&);
+RemoveItem_t* _originalRemoveItem = nullptr;
+RE::ObjectRefHandle* MyRemoveItem(RE::TESObjectREFR* self, RE::ObjectRefHandle* a_result, RE::TESObjectREFR::RemoveItemData& a_data) {
+    static const RE::BSFixedString pipboyMenu{ "PipboyMenu" };
+    auto& service = ProtectionService::GetSingleton();
+    const auto* object = a_data.objectArray.empty() || !a_data.objectArray[0] ? nullptr : a_data.objectArray[0]->As<RE::TESBoundObject>();
+    // One policy snapshot for the whole decision
+    const auto policy = GetLockPolicy();
+    // Only drops issued from the Pip-Boy, scripted and other game-driven drops are left alone.
+    // Workbench component removals are not judged here either: the craft is already granted when they
+    // arrive, so skipping one would hand out a free item. That guard needs the build-confirm path (see README).
+    // Without a stack id do not judge the whole item (avoids blocking other stacks)
+    if (object && policy.drop && policy.LocksAnything() && !a_data.stackData.empty() && a_data.reason == RE::ITEM_REMOVE_REASON::kDropping) {
+        auto* ui = RE::UI::GetSingleton();
+        if (ui && ui->GetMenuOpen(pipboyMenu)) {
+            for (const auto stackId : a_data.stackData) {
+                // The Pip-Boy can equip and favorite while open, so drops re-read the stack
+                if (service.GetPlayerFacts(object, stackId, true).IsProtected(policy)) {
+                    if (DEBUGGING)
+                        REX::INFO("MyRemoveItem: Drop blocked for protected item {:08X} (stackId {})", object->GetFormID(), stackId);
+                    *a_result = RE::ObjectRefHandle{};
+                    return a_result; // Block the drop
+                }
+            }
+        }
+    }
+    auto* result = _originalRemoveItem(self, a_result, a_data);
+    // Removing a player stack shifts the stack ids of that form
+    service.Invalidate(object);
+    return result;
+}
+
+// --- Address table ---
+// Every trampoline hook with its REL ID per runtime (columns follow Runtime: OG, NG, AE)
+struct BranchHook
+{
+    std::string_view name;
+    std::array<std::uint64_t, static_cast<std::size_t>(Runtime::kTotal)> ids;
+    std::size_t branchSize; // 5 (call/jmp rel32) or 6 (jmp [rip])
+    std::uintptr_t replacement;
+    void (*setOriginal)(std::uintptr_t);
+    bool (*enabled)();
+};
+
+static const std::array<BranchHook, 1> g_branchHooks{ {
+    { "ContainerMenu::TakeAllItems"sv, { 1323703, 2248619, 2248619 }, 6, reinterpret_cast<std::uintptr_t>(&MyTakeAllItems),
+        [](std::uintptr_t a_original) { _originalTakeAllItems = reinterpret_cast<TakeAllItems_t*>(a_original); },
+        [] { return GetLockPolicy().takeAll; } },
+} };
+
+// Trampoline space a branch consumes: 6-byte branches only store the target, 5-byte ones need an absolute jump
+constexpr std::size_t TrampolineBytes(std::size_t a_branchSize) {
+    return a_branchSize == 6 ? sizeof(std::uintptr_t) : 14;
+}
+
 // General hook installation function
 bool InstallContainerMenuHooks() {
-    // Get the vtable for ExamineMenu
-    auto vtbl0 = REL::Relocation<std::uintptr_t>(RE::VTABLE::ContainerMenu[0]);
-    // Overwrite vfunc at index 0x15 (21 decimal)
-    _originalContDoItemTransfer = reinterpret_cast<ContDoItemTransfer_t *>(vtbl0.write_vfunc(0x15, &MyContDoItemTransfer));
-    REX::INFO("InstallContainerMenuHooks: Hooked ContainerMenu::DoItemTransfer");
-    // Get the vtable for BarterMenu
-    auto vtbl1 = REL::Relocation<std::uintptr_t>(RE::VTABLE::BarterMenu[0]);
-    // Overwrite vfunc at index 0x15 (22 decimal)
-    _originalBartDoItemTransfer = reinterpret_cast<BartDoItemTransfer_t *>(vtbl1.write_vfunc(0x15, &MyBartDoItemTransfer));
-    REX::INFO("InstallContainerMenuHooks: Hooked BarterMenu::DoItemTransfer");
-    // Get the vtable for ScrapItemCallback
-    auto vtbl2 = REL::Relocation<std::uintptr_t>(RE::VTABLE::__ScrapItemCallback[0]);
-    // Overwrite vfunc at index 0x01 (1 decimal)
-    _originalScrapOnAccept = reinterpret_cast<ScrapOnAccept_t*>(vtbl2.write_vfunc(0x01, &MyScrapOnAccept));
-    REX::INFO("InstallContainerMenuHooks: Hooked ScrapItemCallback::OnAccept");
-    if (!LOCK_TAKEALL) {
+    auto& profiler = StartupProfiler::GetSingleton();
+    {
+        auto phase = profiler.Scope("vtable patches"sv);
+        // Get the vtable for ContainerMenu
+        auto vtbl0 = REL::Relocation<std::uintptr_t>(RE::VTABLE::ContainerMenu[0]);
+        // Overwrite vfunc at index 0x15 (21 decimal)
+        _originalContDoItemTransfer = reinterpret_cast<ContDoItemTransfer_t *>(vtbl0.write_vfunc(0x15, &MyContDoItemTransfer));
+        REX::INFO("InstallContainerMenuHooks: Hooked ContainerMenu::DoItemTransfer");
+        // Get the vtable for BarterMenu
+        auto vtbl1 = REL::Relocation<std::uintptr_t>(RE::VTABLE::BarterMenu[0]);
+        // Overwrite vfunc at index 0x15 (22 decimal)
+        _originalBartDoItemTransfer = reinterpret_cast<BartDoItemTransfer_t *>(vtbl1.write_vfunc(0x15, &MyBartDoItemTransfer));
+        REX::INFO("InstallContainerMenuHooks: Hooked BarterMenu::DoItemTransfer");
+        // Get the vtable for ScrapItemCallback
+        auto vtbl2 = REL::Relocation<std::uintptr_t>(RE::VTABLE::__ScrapItemCallback[0]);
+        // Overwrite vfunc at index 0x01 (1 decimal)
+        _originalScrapOnAccept = reinterpret_cast<ScrapOnAccept_t*>(vtbl2.write_vfunc(0x01, &MyScrapOnAccept));
+        REX::INFO("InstallContainerMenuHooks: Hooked ScrapItemCallback::OnAccept");
+        // Get the vtable for PlayerCharacter
+        auto vtbl3 = REL::Relocation<std::uintptr_t>(RE::VTABLE::PlayerCharacter[0]);
+        // Overwrite TESObjectREFR::RemoveItem at index 0x7A (122 decimal)
+        _originalRemoveItem = reinterpret_cast<RemoveItem_t*>(vtbl3.write_vfunc(0x7A, &MyRemoveItem));
+        REX::INFO("InstallContainerMenuHooks: Hooked PlayerCharacter::RemoveItem");
+    }
+    // Resolve the addresses of the enabled branch hooks from the table row for this runtime
+    struct ResolvedHook {
+        const BranchHook* hook;
+        std::uintptr_t address;
+    };
+    std::array<ResolvedHook, g_branchHooks.size()> resolved{};
+    std::size_t resolvedCount = 0;
+    std::size_t trampolineSize = 0;
+    {
+        auto phase = profiler.Scope("address resolution"sv);
+        const auto column = static_cast<std::size_t>(g_runtime);
+        for (const auto& hook : g_branchHooks) {
+            if (!hook.enabled())
+                continue;
+            resolved[resolvedCount++] = { &hook, REL::ID(hook.ids[column]).address() };
+            trampolineSize += TrampolineBytes(hook.branchSize);
+        }
+    }
+    if (resolvedCount == 0) {
         REX::INFO("InstallContainerMenuHooks: All menu hooks installed.");
         return true;
     }
-    // Try to find the relocation ID for RE::ContainerMenu::TakeAllItems
-    REX::INFO("InstallContainerMenuHooks: Installing ContainerMenu::TakeAllItems hook...");
-    // Map per-version
-    REL::ID takeAllId = REL::ID(1323703); // fallback / older (1.10.163)
-    if (g_moduleName == "InvLockerCLX") {
-        takeAllId = REL::ID(2248619);
-    } else if (g_moduleName == "InvLockerCLXAE") {
-        takeAllId = REL::ID(2248619);
-    }
-    // Create trampoline for branch/call hooks (do this BEFORE write_branch calls)
-    bool skipTakeAllHook = false;
-    try {
-        constexpr std::size_t TRAMPOLINE_SIZE = 64 * 1024;
-        F4SE::GetTrampoline().create(TRAMPOLINE_SIZE); // let create() choose module
-        REX::INFO("Trampoline created ({} bytes)", TRAMPOLINE_SIZE);
-    } catch (const std::exception& e) {
-        REX::WARN("Failed to create trampoline: {}", e.what());
-        skipTakeAllHook = true; // guard installing branch hooks later
+    // Create trampoline sized for the registered branch hooks (do this BEFORE write_branch calls)
+    {
+        auto phase = profiler.Scope("trampoline"sv);
+        try {
+            F4SE::GetTrampoline().create(trampolineSize); // let create() choose module
+            profiler.SetTrampoline(resolvedCount, trampolineSize);
+            REX::INFO("Trampoline created ({} bytes for {} hook(s))", trampolineSize, resolvedCount);
+        } catch (const std::exception& e) {
+            REX::WARN("Failed to create trampoline: {}", e.what());
+            REX::WARN("InstallContainerMenuHooks: Skipping branch hooks due to trampoline creation failure.");
+            return true; // continue without these hooks
+        }
     }
-    if (skipTakeAllHook) {
-        REX::WARN("InstallContainerMenuHooks: Skipping ContainerMenu::TakeAllItems hook due to trampoline creation failure.");
-        return true; // continue without this hook
+    {
+        auto phase = profiler.Scope("branch hooks"sv);
+        auto& trampoline = F4SE::GetTrampoline();
+        for (std::size_t i = 0; i < resolvedCount; ++i) {
+            const auto& [hook, address] = resolved[i];
+            const auto original = hook->branchSize == 5 ? trampoline.write_branch<5>(address, hook->replacement) : trampoline.write_branch<6>(address, hook->replacement);
+            hook->setOriginal(original);
+            REX::INFO("InstallContainerMenuHooks: hooked {} using REL id {}", hook->name, hook->ids[static_cast<std::size_t>(g_runtime)]);
+        }
     }
-    using func_t = decltype(&RE::ContainerMenu::TakeAllItems);
-    static REL::Relocation<func_t> rel{ takeAllId };
-    _originalTakeAllItems = reinterpret_cast<TakeAllItems_t*>(F4SE::GetTrampoline().write_branch<6>(rel.address(), MyTakeAllItems));
-    REX::INFO("InstallContainerMenuHooks: hooked ContainerMenu::TakeAllItems using REL id {}", takeAllId.id());
     // Log completion
     REX::INFO("InstallContainerMenuHooks: All menu hooks installed.");
     return true;
 }
 
+// Log arena and cache stats when an inventory menu closes, if the cache was used since the last line
+static void LogMenuStats() {
+    static std::size_t lastQueries = 0;
+    const auto& arena = MenuArena::GetSingleton();
+    const auto& cache = ProtectionService::GetSingleton().GetCache();
+    const auto queries = cache.GetHits() + cache.GetMisses();
+    if (queries == lastQueries)
+        return;
+    lastQueries = queries;
+    REX::INFO("Stats: menu arena sessions {}, capacity {} bytes, high-water {} bytes | protection cache hits {}, misses {}", arena.GetSessions(), arena.GetCapacity(), arena.GetHighWater(), cache.GetHits(), cache.GetMisses());
+}
+
+// Release the menu arena when an inventory menu closes
+class MenuCloseWatcher : public RE::BSTEventSink<RE::MenuOpenCloseEvent>
+{
+public:
+    static MenuCloseWatcher* GetSingleton() {
+        static MenuCloseWatcher singleton;
+        return &singleton;
+    }
+    RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent& a_event, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+        if (a_event.opening)
+            return RE::BSEventNotifyControl::kContinue;
+        const std::string_view name = a_event.menuName.c_str();
+        if (name == "ContainerMenu"sv || name == "BarterMenu"sv || name == "ExamineMenu"sv || name == "PipboyMenu"sv) {
+            MenuArena::GetSingleton().Release();
+            LogMenuStats();
+        }
+        // Favorites are only toggled in the Pip-Boy
+        if (name == "PipboyMenu"sv) {
+            ProtectionService::GetSingleton().OnFavoritesChanged();
+        }
+        return RE::BSEventNotifyControl::kContinue;
+    }
+};
+
+// Register the menu open/close sink
+bool RegisterMenuEventSink() {
+    auto* ui = RE::UI::GetSingleton();
+    if (!ui)
+        return false;
+    ui->RegisterSink<RE::MenuOpenCloseEvent>(MenuCloseWatcher::GetSingleton());
+    REX::INFO("RegisterMenuEventSink: Registered MenuOpenCloseEvent sink");
+    return true;
+}
+
 // Register Papyrus functions
 bool RegisterPapyrusFunctions(RE::BSScript::IVirtualMachine *vm) {
     if (DEBUGGING)
@@ -1,5 +1,6 @@
 #pragma once
 #include <Global.h>
+#include <LockPolicy.h>
 
 // --- Hooks ---
 
@@ -7,10 +8,11 @@
 
 // --- Functions ---
 
-bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::InventoryUserUIInterfaceEntry* a_entry);
+bool CheckEquippedOrFavorite(RE::BGSInventoryInterface* invInterface, const RE::InventoryUserUIInterfaceEntry* a_entry, const LockPolicy& a_policy);
 bool IsContainerDeadActor(RE::ContainerMenu* a_menu);
 bool IsItemEquipped(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId);
 bool IsItemFavorite(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId);
 
 bool InstallContainerMenuHooks();
+bool RegisterMenuEventSink();
 bool RegisterPapyrusFunctions(RE::BSScript::IVirtualMachine *vm);
\ No newline at end of file
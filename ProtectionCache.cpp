@@ -0,0 +1,40 @@
+#include <PCH.h>
+#include <ProtectionCache.h>
+
+void ProtectionCache::Invalidate(std::uint32_t a_formID) {
+    std::scoped_lock locker{ _lock };
+    ++_generation;
+    std::erase_if(_facts, [a_formID](const auto& a_entry) { return (a_entry.first >> 32) == a_formID; });
+}
+
+void ProtectionCache::Clear() {
+    std::scoped_lock locker{ _lock };
+    ++_generation;
+    _facts.clear();
+}
+
+void ProtectionCache::Reserve(std::size_t a_entries) {
+    std::scoped_lock locker{ _lock };
+    _facts.reserve(a_entries);
+}
+
+bool ProtectionCache::Find(std::uint64_t a_key, bool a_refresh, Facts& a_facts, std::uint64_t& a_generation) {
+    std::scoped_lock locker{ _lock };
+    a_generation = _generation;
+    if (a_refresh)
+        return false;
+    const auto it = _facts.find(a_key);
+    if (it == _facts.end()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    a_facts = it->second;
+    return true;
+}
+
+void ProtectionCache::Store(std::uint64_t a_key, const Facts& a_facts, std::uint64_t a_generation) {
+    std::scoped_lock locker{ _lock };
+    if (a_generation == _generation)
+        _facts[a_key] = a_facts;
+}
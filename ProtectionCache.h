@@ -0,0 +1,60 @@
+#pragma once
+#include <PCH.h>
+#include <LockPolicy.h>
+
+// --- Protection cache ---
+// Equipped/favorite facts of the player's stacks keyed by (form id, stack id). Shared by every hook
+// and reader thread and kept across menus. A form's entries are dropped when its stacks change,
+// everything is dropped when equip or favorite state may have changed.
+// A miss reads the game outside the lock and only stores if no invalidation happened meanwhile,
+// so a read racing an invalidation never leaves a stale entry behind.
+class ProtectionCache
+{
+public:
+    struct Facts
+    {
+        bool equipped = false;
+        bool favorite = false;
+
+        bool IsProtected(const LockPolicy& a_policy) const { return (a_policy.equipped && equipped) || (a_policy.favorites && favorite); }
+    };
+
+    // Cached facts, or a_compute() on a miss (a_refresh always reads).
+    // a_compute returns std::optional<Facts>, std::nullopt if the stack does not exist (nothing is cached then)
+    template <class F>
+    Facts Get(std::uint32_t a_formID, std::uint32_t a_stackId, bool a_refresh, F&& a_compute)
+    {
+        const auto key = MakeKey(a_formID, a_stackId);
+        Facts facts;
+        std::uint64_t generation = 0;
+        if (Find(key, a_refresh, facts, generation))
+            return facts;
+        const std::optional<Facts> computed = a_compute();
+        if (!computed)
+            return {};
+        Store(key, *computed, generation);
+        return *computed;
+    }
+
+    // Stacks of this form were added or removed, their stack ids shifted
+    void Invalidate(std::uint32_t a_formID);
+    // Equip or favorite state may have changed anywhere
+    void Clear();
+    void Reserve(std::size_t a_entries);
+
+    std::size_t GetHits() const { return _hits.load(std::memory_order_relaxed); }
+    std::size_t GetMisses() const { return _misses.load(std::memory_order_relaxed); }
+
+private:
+    static std::uint64_t MakeKey(std::uint32_t a_formID, std::uint32_t a_stackId) { return (static_cast<std::uint64_t>(a_formID) << 32) | a_stackId; }
+
+    bool Find(std::uint64_t a_key, bool a_refresh, Facts& a_facts, std::uint64_t& a_generation);
+    void Store(std::uint64_t a_key, const Facts& a_facts, std::uint64_t a_generation);
+
+    std::mutex _lock;
+    std::unordered_map<std::uint64_t, Facts> _facts;
+    // Bumped by every invalidation, a miss may only store under the generation it started with
+    std::uint64_t _generation = 0;
+    std::atomic<std::size_t> _hits{ 0 };
+    std::atomic<std::size_t> _misses{ 0 };
+};
@@ -0,0 +1,91 @@
+#include <Global.h>
+#include <ProtectionService.h>
+
+// Form id of the player reference
+static constexpr std::uint32_t PLAYER_REF_ID = 0x14;
+
+// Player inventory list, nullptr before a game is loaded
+static RE::BGSInventoryList* GetPlayerInventory() {
+    auto* player = RE::PlayerCharacter::GetSingleton();
+    return player ? player->inventoryList : nullptr;
+}
+
+ProtectionService& ProtectionService::GetSingleton() {
+    static ProtectionService singleton;
+    return singleton;
+}
+
+bool ProtectionService::RegisterEventSinks() {
+    auto* equipSource = RE::TESEquipEvent::GetEventSource();
+    auto* containerSource = RE::TESContainerChangedEvent::GetEventSource();
+    if (!equipSource || !containerSource)
+        return false;
+    equipSource->RegisterSink(this);
+    containerSource->RegisterSink(this);
+    REX::INFO("ProtectionService: Registered TESEquipEvent and TESContainerChangedEvent sinks");
+    return true;
+}
+
+void ProtectionService::Reset() {
+    _cache.Clear();
+    if (auto* inventory = GetPlayerInventory()) {
+        RE::BSAutoReadLock inventoryLock{ inventory->rwLock };
+        _cache.Reserve(inventory->data.size());
+    }
+}
+
+ProtectionService::Facts ProtectionService::GetFacts(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId, bool a_refresh) {
+    if (!a_item || !a_item->object)
+        return {};
+    // Container and vendor stacks are not owned by the service
+    if (!IsPlayerItem(a_item))
+        return Compute(a_item, a_stackId);
+    return _cache.Get(a_item->object->GetFormID(), a_stackId, a_refresh, [&]() -> std::optional<Facts> { return Compute(a_item, a_stackId); });
+}
+
+ProtectionService::Facts ProtectionService::GetPlayerFacts(const RE::TESBoundObject* a_object, std::uint32_t a_stackId, bool a_refresh) {
+    if (!a_object)
+        return {};
+    return _cache.Get(a_object->GetFormID(), a_stackId, a_refresh, [&]() -> std::optional<Facts> {
+        auto* inventory = GetPlayerInventory();
+        if (!inventory)
+            return std::nullopt;
+        RE::BSAutoReadLock inventoryLock{ inventory->rwLock };
+        const auto it = std::find_if(inventory->data.begin(), inventory->data.end(), [&](const RE::BGSInventoryItem& a_item) { return a_item.object == a_object; });
+        if (it == inventory->data.end())
+            return std::nullopt;
+        return Compute(&*it, a_stackId);
+    });
+}
+
+void ProtectionService::Invalidate(const RE::TESBoundObject* a_object) {
+    if (a_object)
+        _cache.Invalidate(a_object->GetFormID());
+}
+
+RE::BSEventNotifyControl ProtectionService::ProcessEvent(const RE::TESEquipEvent& a_event, RE::BSTEventSource<RE::TESEquipEvent>*) {
+    // Equipping one item can unequip others sharing its slots, drop everything
+    if (a_event.actor && a_event.actor.get() == RE::PlayerCharacter::GetSingleton())
+        _cache.Clear();
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl ProtectionService::ProcessEvent(const RE::TESContainerChangedEvent& a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) {
+    // Stacks of the form were added to or removed from the player
+    if (a_event.oldContainer == PLAYER_REF_ID || a_event.newContainer == PLAYER_REF_ID)
+        _cache.Invalidate(a_event.baseObj);
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+bool ProtectionService::IsPlayerItem(const RE::BGSInventoryItem* a_item) {
+    auto* inventory = GetPlayerInventory();
+    if (!inventory)
+        return false;
+    RE::BSAutoReadLock inventoryLock{ inventory->rwLock };
+    const auto* first = inventory->data.data();
+    return first && a_item >= first && a_item < first + inventory->data.size();
+}
+
+ProtectionService::Facts ProtectionService::Compute(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId) {
+    return { IsItemEquipped(a_item, a_stackId), IsItemFavorite(a_item, a_stackId) };
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <Global.h>
+#include <ProtectionCache.h>
+
+// --- Protection service ---
+// Single owner of the lock state of the player inventory, shared by every hook
+// (container/barter transfers, Take All, scrapping and Pip-Boy drops). Facts go through one
+// ProtectionCache that survives menus, so a decision made in one menu is reused by the others.
+// The LockPolicy is applied on every query, a config reload never has to flush the cache.
+// Invalidation: equip events and closing the Pip-Boy (the only place favorites change) drop
+// everything, container changes and removals of the player drop the form involved.
+class ProtectionService :
+    public RE::BSTEventSink<RE::TESEquipEvent>,
+    public RE::BSTEventSink<RE::TESContainerChangedEvent>
+{
+public:
+    using Facts = ProtectionCache::Facts;
+
+    static ProtectionService& GetSingleton();
+
+    bool RegisterEventSinks();
+    // New game or save loaded, forget the previous player inventory
+    void Reset();
+    // Favorites may have been toggled (Pip-Boy closed)
+    void OnFavoritesChanged() { _cache.Clear(); }
+
+    // Facts for a stack of any inventory item, only player stacks are cached
+    Facts GetFacts(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId, bool a_refresh = false);
+    // Facts for a stack of the player's item of this form (drop path)
+    Facts GetPlayerFacts(const RE::TESBoundObject* a_object, std::uint32_t a_stackId, bool a_refresh = false);
+    // A player stack of this form was removed, its cached stack ids are stale
+    void Invalidate(const RE::TESBoundObject* a_object);
+
+    const ProtectionCache& GetCache() const { return _cache; }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent& a_event, RE::BSTEventSource<RE::TESEquipEvent>*) override;
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent& a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) override;
+
+private:
+    ProtectionService() = default;
+
+    static bool IsPlayerItem(const RE::BGSInventoryItem* a_item);
+    static Facts Compute(const RE::BGSInventoryItem* a_item, std::uint32_t a_stackId);
+
+    ProtectionCache _cache;
+};
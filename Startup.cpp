@@ -0,0 +1,50 @@
+#include <Global.h>
+#include <Startup.h>
+
+// Private bytes committed by the process
+static std::int64_t GetPrivateBytes() {
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return static_cast<std::int64_t>(counters.PagefileUsage);
+}
+
+StartupProfiler::Phase::Phase(StartupProfiler& a_owner, std::string_view a_name) :
+    _owner(a_owner),
+    _name(a_name),
+    _start(std::chrono::steady_clock::now()),
+    _startBytes(GetPrivateBytes())
+{}
+
+StartupProfiler::Phase::~Phase() {
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - _start;
+    _owner.Record(_name, elapsed.count(), GetPrivateBytes() - _startBytes);
+}
+
+StartupProfiler& StartupProfiler::GetSingleton() {
+    static StartupProfiler singleton;
+    return singleton;
+}
+
+void StartupProfiler::Record(std::string_view a_name, double a_ms, std::int64_t a_bytes) {
+    if (_count < _entries.size())
+        _entries[_count++] = { a_name, a_ms, a_bytes };
+}
+
+void StartupProfiler::SetTrampoline(std::size_t a_hooks, std::size_t a_bytes) {
+    _trampolineHooks = a_hooks;
+    _trampolineBytes = a_bytes;
+}
+
+void StartupProfiler::Report() const {
+    double totalMs = 0.0;
+    std::int64_t totalBytes = 0;
+    std::string phases;
+    for (std::size_t i = 0; i < _count; ++i) {
+        const auto& entry = _entries[i];
+        totalMs += entry.ms;
+        totalBytes += entry.bytes;
+        phases += std::format("{}{} {:.3f}ms", phases.empty() ? "" : ", ", entry.name, entry.ms);
+    }
+    REX::INFO("Startup: {:.3f}ms total ({}) | trampoline {} bytes for {} hook(s) | +{} KiB private", totalMs, phases, _trampolineBytes, _trampolineHooks, (std::max)(totalBytes, std::int64_t{ 0 }) / 1024);
+}
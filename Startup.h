@@ -0,0 +1,49 @@
+#pragma once
+#include <PCH.h>
+
+// --- Startup profiling ---
+// Times each phase of F4SEPlugin_Query/F4SEPlugin_Load and the private memory it commits.
+// Report() writes everything as one line so the plugin's load cost can be read at a glance.
+class StartupProfiler
+{
+public:
+    static constexpr std::size_t MAX_PHASES = 16;
+
+    // RAII scope, records its phase when destroyed
+    class Phase
+    {
+    public:
+        Phase(StartupProfiler& a_owner, std::string_view a_name);
+        ~Phase();
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        StartupProfiler& _owner;
+        std::string_view _name;
+        std::chrono::steady_clock::time_point _start;
+        std::int64_t _startBytes;
+    };
+
+    static StartupProfiler& GetSingleton();
+
+    [[nodiscard]] Phase Scope(std::string_view a_name) { return Phase(*this, a_name); }
+    void SetTrampoline(std::size_t a_hooks, std::size_t a_bytes);
+    void Report() const;
+
+private:
+    struct Entry
+    {
+        std::string_view name;
+        double ms;
+        std::int64_t bytes;
+    };
+
+    StartupProfiler() = default;
+    void Record(std::string_view a_name, double a_ms, std::int64_t a_bytes);
+
+    std::array<Entry, MAX_PHASES> _entries{};
+    std::size_t _count = 0;
+    std::size_t _trampolineHooks = 0;
+    std::size_t _trampolineBytes = 0;
+};
@@ -1,4 +1,6 @@
 #include <Global.h>
+#include <ProtectionService.h>
+#include <Startup.h>
 
 // Global logger pointer
 std::shared_ptr<spdlog::logger> gLog;
@@ -23,6 +25,8 @@ namespace Version
 
 // Global Module Name
 std::string g_moduleName = "InvLockerCL";
+// Runtime column of the address table
+Runtime g_runtime = Runtime::kOG;
 // Declare the F4SEMessagingInterface and F4SEScaleformInterface
 const F4SE::MessagingInterface *g_messaging = nullptr;
 // Papyrus interface
@@ -39,17 +43,10 @@ RE::TESDataHandler *g_dataHandle = 0;
 // Variables
 
 // Global debug flag
-bool DEBUGGING = false;
-// Lock equipped inventory items
-bool LOCK_EQUIPPED = true;
-// Lock favorite inventory items
-bool LOCK_FAVORITES = true;
-// Lock scrapping of equipped and/or favorite inventory items
-bool LOCK_SCRAP = true;
-// Bi-directional locking
-bool LOCK_BIDIRECTIONAL = true;
-// Lock when using Take All Items
-bool LOCK_TAKEALL = true;
+std::atomic<bool> DEBUGGING = false;
+
+// Default INI to write once loading is done (empty if the INI exists)
+std::string g_pendingDefaultIni;
 
 // Helper function to extract value from a line
 inline std::string GetValueFromLine(const std::string &line)
@@ -83,24 +80,12 @@ void LoadConfig(HMODULE hModule)
     std::ifstream file(configPath);
     // Check if the file opened successfully
     if (!file.is_open()) {
-        REX::WARN("LoadConfig: Could not open INI file: {}. Creating default.", configPath);
-        // Create the file with defaultIni contents
-        std::ofstream out(configPath);
-        if (out.is_open()) {
-            out << defaultIni;
-            out.close();
-            REX::INFO("LoadConfig: Default INI created at: {}", configPath);
-        } else {
-            REX::WARN("LoadConfig: Failed to create default INI at: {}", configPath);
-            return;
-        }
-        // Try to open again for reading
-        file.open(configPath);
-        if (!file.is_open()) {
-            REX::WARN("LoadConfig: Still could not open INI file after creating default: {}", configPath);
-            return;
-        }
+        // Keep the built-in defaults and write the file after loading instead of blocking F4SEPlugin_Load
+        REX::WARN("LoadConfig: Could not open INI file: {}. Using defaults, default INI is created after load.", configPath);
+        g_pendingDefaultIni = configPath;
     }
+    // Parse into a local copy and publish it at once, readers never see a half-loaded config
+    LockPolicy policy = GetLockPolicy();
     std::string line;
     while (std::getline(file, line)) {
         // Trim whitespace
@@ -125,9 +110,9 @@ void LoadConfig(HMODULE hModule)
         if (lowerLine.find("lock_equipped") == 0) {
             std::string value = GetValueFromLine(line);
             if (ToLower(value) == "false" || value == "0") {
-                LOCK_EQUIPPED = false;
+                policy.equipped = false;
             } else {
-                LOCK_EQUIPPED = true;
+                policy.equipped = true;
             }
             continue;
         }
@@ -135,9 +120,9 @@ void LoadConfig(HMODULE hModule)
         if (lowerLine.find("lock_favorites") == 0) {
             std::string value = GetValueFromLine(line);
             if (ToLower(value) == "false" || value == "0") {
-                LOCK_FAVORITES = false;
+                policy.favorites = false;
             } else {
-                LOCK_FAVORITES = true;
+                policy.favorites = true;
             }
             continue;
         }
@@ -145,9 +130,9 @@ void LoadConfig(HMODULE hModule)
         if (lowerLine.find("lock_scrap") == 0) {
             std::string value = GetValueFromLine(line);
             if (ToLower(value) == "false" || value == "0") {
-                LOCK_SCRAP = false;
+                policy.scrap = false;
             } else {
-                LOCK_SCRAP = true;
+                policy.scrap = true;
             }
             continue;
         }
@@ -155,9 +140,9 @@ void LoadConfig(HMODULE hModule)
         if (lowerLine.find("lock_bidirectional") == 0) {
             std::string value = GetValueFromLine(line);
             if (ToLower(value) == "false" || value == "0") {
-                LOCK_BIDIRECTIONAL = false;
+                policy.bidirectional = false;
             } else {
-                LOCK_BIDIRECTIONAL = true;
+                policy.bidirectional = true;
             }
             continue;
         }
@@ -165,21 +150,49 @@ void LoadConfig(HMODULE hModule)
         if (lowerLine.find("lock_takeall") == 0) {
             std::string value = GetValueFromLine(line);
             if (ToLower(value) == "false" || value == "0") {
-                LOCK_TAKEALL = false;
+                policy.takeAll = false;
+            } else {
+                policy.takeAll = true;
+            }
+            continue;
+        }
+        // --- Lock dropping flag ---
+        if (lowerLine.find("lock_drop") == 0) {
+            std::string value = GetValueFromLine(line);
+            if (ToLower(value) == "false" || value == "0") {
+                policy.drop = false;
             } else {
-                LOCK_TAKEALL = true;
+                policy.drop = true;
             }
             continue;
         }
     }
     file.close();
+    SetLockPolicy(policy);
     REX::INFO("LoadConfig: Completed loading config.");
-    REX::INFO(" - Debugging: {}", DEBUGGING);
-    REX::INFO(" - Lock Equipped Inventory Items: {}", LOCK_EQUIPPED);
-    REX::INFO(" - Lock Favorite Inventory Items: {}", LOCK_FAVORITES);
-    REX::INFO(" - Lock Scrapping of Equipped/Favorite Items: {}", LOCK_SCRAP);
-    REX::INFO(" - Lock Bi-Directional: {}", LOCK_BIDIRECTIONAL);
-    REX::INFO(" - Lock Take All Items: {}", LOCK_TAKEALL);
+    REX::INFO(" - Debugging: {}", DEBUGGING.load());
+    REX::INFO(" - Lock Equipped Inventory Items: {}", policy.equipped);
+    REX::INFO(" - Lock Favorite Inventory Items: {}", policy.favorites);
+    REX::INFO(" - Lock Scrapping of Equipped/Favorite Items: {}", policy.scrap);
+    REX::INFO(" - Lock Bi-Directional: {}", policy.bidirectional);
+    REX::INFO(" - Lock Take All Items: {}", policy.takeAll);
+    REX::INFO(" - Lock Dropping of Equipped/Favorite Items: {}", policy.drop);
+}
+
+// Write the default INI deferred by LoadConfig
+void WriteDefaultConfig()
+{
+    if (g_pendingDefaultIni.empty())
+        return;
+    std::ofstream out(g_pendingDefaultIni);
+    if (out.is_open()) {
+        out << defaultIni;
+        out.close();
+        REX::INFO("WriteDefaultConfig: Default INI created at: {}", g_pendingDefaultIni);
+    } else {
+        REX::WARN("WriteDefaultConfig: Failed to create default INI at: {}", g_pendingDefaultIni);
+    }
+    g_pendingDefaultIni.clear();
 }
 
 // Message handler definition
@@ -187,6 +200,7 @@ void F4SEMessageHandler(F4SE::MessagingInterface::Message *a_message) {
     switch (a_message->type) {
         case F4SE::MessagingInterface::kPostLoad:
             REX::INFO("Received kMessage_PostLoad. Game data is now loaded!");
+            WriteDefaultConfig();
             break;
         case F4SE::MessagingInterface::kPostPostLoad:
             REX::INFO("Received kMessage_PostPostLoad. Game data finished loading.");
@@ -200,12 +214,22 @@ void F4SEMessageHandler(F4SE::MessagingInterface::Message *a_message) {
             } else {
                 REX::WARN("Failed to acquire TESDataHandler singleton.");
             }
+            // Menu close releases the per-menu arena
+            if (!RegisterMenuEventSink()) {
+                REX::WARN("Failed to register MenuOpenCloseEvent sink.");
+            }
+            // Equip and container changes invalidate the protection cache
+            if (!ProtectionService::GetSingleton().RegisterEventSinks()) {
+                REX::WARN("Failed to register protection service event sinks.");
+            }
             break;
         case F4SE::MessagingInterface::kPostLoadGame:
             REX::INFO("Received kMessage_PostLoadGame. A save game has been loaded.");
+            ProtectionService::GetSingleton().Reset();
             break;
         case F4SE::MessagingInterface::kNewGame:
             REX::INFO("Received kMessage_NewGame. A new game has been started.");
+            ProtectionService::GetSingleton().Reset();
             break;
     }
 }
@@ -221,24 +245,30 @@ extern "C"
         info->infoVersion = F4SE::PluginInfo::kVersion;
         info->name = Version::PROJECT.data();
         info->version = Version::MAJOR;
-        // Set up the logger
-        // F4SE::log::log_directory().value(); == Documents/My Games/F4SE/
-        std::filesystem::path logPath = F4SE::log::log_directory().value();
-        logPath = logPath.parent_path() / "Fallout4" / "F4SE" / std::format("{}.log", Version::PROJECT);
-        // Create the file
-        auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logPath.string(), true);
-        auto aLog = std::make_shared<spdlog::logger>("aLog"s, sink);
-        // Configure the logger
-        aLog->set_level(spdlog::level::info);
-        aLog->flush_on(spdlog::level::info);
-        // Set pattern
-        aLog->set_pattern("[%T] [%^%l%$] %v"s);
-        // Register to make it global accessable
-        spdlog::register_logger(aLog);
-        // Assign to global pointer
-        gLog = spdlog::get("aLog");
+        auto& profiler = StartupProfiler::GetSingleton();
+        {
+            auto phase = profiler.Scope("logger"sv);
+            // Set up the logger
+            // F4SE::log::log_directory().value(); == Documents/My Games/F4SE/
+            std::filesystem::path logPath = F4SE::log::log_directory().value();
+            logPath = logPath.parent_path() / "Fallout4" / "F4SE" / std::format("{}.log", Version::PROJECT);
+            // Create the file
+            auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(logPath.string(), true);
+            auto aLog = std::make_shared<spdlog::logger>("aLog"s, sink);
+            // Configure the logger
+            aLog->set_level(spdlog::level::info);
+            aLog->flush_on(spdlog::level::info);
+            // Set pattern
+            aLog->set_pattern("[%T] [%^%l%$] %v"s);
+            // Register to make it global accessable
+            spdlog::register_logger(aLog);
+            // Assign to global pointer
+            gLog = spdlog::get("aLog");
+        }
         // First log
         REX::INFO("{}: Plugin Query started.", Version::PROJECT);
+        // Pick the address table column once
+        g_runtime = ResolveRuntime(g_moduleName);
         // Minimum version 1.10.163
         const auto ver = f4se->RuntimeVersion();
         if (ver < F4SE::RUNTIME_1_10_162) {
@@ -250,8 +280,12 @@ extern "C"
 
     // This function is called after F4SE has loaded all plugins and the game is about to start.
     F4SE_API bool F4SEPlugin_Load(const F4SE::LoadInterface *f4se) {
+        auto& profiler = StartupProfiler::GetSingleton();
         // Initialize the plugin with logger false to prevent F4SE to use its own logger
-        F4SE::Init(f4se, false);
+        {
+            auto phase = profiler.Scope("init"sv);
+            F4SE::Init(f4se, false);
+        }
         // Log information
         REX::INFO("{}: Plugin loaded!", Version::PROJECT);
         REX::INFO("F4SE version: {}", F4SE::GetF4SEVersion().string());
@@ -263,7 +297,10 @@ extern "C"
         // Get the DLL handle for this plugin
         HMODULE hModule = GetModuleHandleA("InvLockerCL.dll");
         // Load config
-        LoadConfig(hModule);
+        {
+            auto phase = profiler.Scope("config"sv);
+            LoadConfig(hModule);
+        }
         // Register Papyrus functions
         if (g_papyrus) {
             g_papyrus->Register(RegisterPapyrusFunctions);
@@ -278,7 +315,13 @@ extern "C"
             REX::WARN("Failed to install ContainerMenu hooks.");
         }
         // Set the messagehandler to listen to events
-        if (g_messaging && g_messaging->RegisterListener(F4SEMessageHandler, "F4SE")) {
+        bool listening = false;
+        {
+            auto phase = profiler.Scope("listeners"sv);
+            listening = g_messaging && g_messaging->RegisterListener(F4SEMessageHandler, "F4SE");
+        }
+        profiler.Report();
+        if (listening) {
             REX::INFO("Registered F4SE message handler.");
         } else {
             REX::WARN("Failed to register F4SE message handler.");
@@ -0,0 +1,373 @@
+#include <Global.h>
+#include <MenuArena.h>
+#include <ProtectionCache.h>
+#include <cstdlib>
+
+// Stress test for the shared lock state:
+//  - one UI thread issues DoItemTransfer and Take All against a mock ContainerMenu, the way the hooks do
+//  - reader threads query lock decisions through the ProtectionCache, the way Papyrus threads would
+//  - one writer reloads the LockPolicy and toggles equip/favorite flags, invalidating like the event sinks
+// Decisions are checked against the mock inventory whenever it did not change during the query.
+// Meant to run under ThreadSanitizer and AddressSanitizer (see CMakeLists.txt).
+
+std::atomic<bool> DEBUGGING = false;
+
+using Facts = ProtectionCache::Facts;
+
+// --- Mock inventory ---
+
+struct MockStack
+{
+    bool equipped = false;
+    bool favorite = false;
+    // Never toggled by the writer, pinned favorites must never leave the player
+    bool pinned = false;
+};
+
+struct MockItem
+{
+    // Like the inventory handle of a BGSInventoryItem: one per item, shared by all its stacks
+    std::uint32_t handle = 0;
+    std::uint32_t formID = 0;
+    // Stack id is the position, removing a stack shifts the ids behind it like in the game
+    std::vector<MockStack> stacks;
+};
+
+// Inventory guarded like BGSInventoryList::rwLock, version bumped by every change
+struct MockInventory
+{
+    std::shared_mutex lock;
+    std::vector<MockItem> items;
+    std::atomic<std::uint64_t> version{ 0 };
+    std::uint32_t nextHandle = 1;
+
+    MockItem& Add(std::uint32_t a_formID) { return items.emplace_back(MockItem{ nextHandle++, a_formID, {} }); }
+
+    MockItem* Find(std::uint32_t a_formID) {
+        const auto it = std::find_if(items.begin(), items.end(), [&](const MockItem& a_item) { return a_item.formID == a_formID; });
+        return it == items.end() ? nullptr : &*it;
+    }
+    std::optional<Facts> GetFacts(std::uint32_t a_formID, std::uint32_t a_stackId) {
+        auto* item = Find(a_formID);
+        if (!item || a_stackId >= item->stacks.size())
+            return std::nullopt;
+        const auto& stack = item->stacks[a_stackId];
+        return Facts{ stack.equipped, stack.favorite };
+    }
+};
+
+// --- Mock protection service ---
+// Same flow as ProtectionService::GetPlayerFacts: cache first, the inventory read lock only on a miss
+
+struct MockService
+{
+    ProtectionCache cache;
+    MockInventory player;
+    MockInventory container;
+
+    Facts GetPlayerFacts(std::uint32_t a_formID, std::uint32_t a_stackId, bool a_refresh = false) {
+        return cache.Get(a_formID, a_stackId, a_refresh, [&]() {
+            std::optional<Facts> facts;
+            {
+                std::shared_lock locker{ player.lock };
+                facts = player.GetFacts(a_formID, a_stackId);
+            }
+            // Widen the window between reading the inventory and storing into the cache,
+            // where a concurrent toggle must keep the stale result out
+            std::this_thread::yield();
+            return facts;
+        });
+    }
+    // Container stacks are not cached, like in the plugin
+    Facts GetContainerFacts(std::uint32_t a_formID, std::uint32_t a_stackId) {
+        std::shared_lock locker{ container.lock };
+        return container.GetFacts(a_formID, a_stackId).value_or(Facts{});
+    }
+    // Move one stack, invalidating the form like the RemoveItem hook and TESContainerChangedEvent.
+    // The game invalidates right after its lock is released; here it happens inside so readers can
+    // compare against the version exactly. Returns the moved stack.
+    std::optional<MockStack> MoveStack(bool a_fromContainer, std::uint32_t a_formID, std::uint32_t a_stackId) {
+        auto& from = a_fromContainer ? container : player;
+        auto& to = a_fromContainer ? player : container;
+        std::scoped_lock locker{ player.lock, container.lock };
+        auto* item = from.Find(a_formID);
+        if (!item || a_stackId >= item->stacks.size())
+            return std::nullopt;
+        const auto stack = item->stacks[a_stackId];
+        item->stacks.erase(item->stacks.begin() + a_stackId);
+        auto* target = to.Find(a_formID);
+        if (!target)
+            target = &to.Add(a_formID);
+        target->stacks.push_back(stack);
+        cache.Invalidate(a_formID);
+        player.version.fetch_add(1, std::memory_order_release);
+        container.version.fetch_add(1, std::memory_order_release);
+        return stack;
+    }
+};
+
+// --- Mock ContainerMenu ---
+
+struct MockEntry
+{
+    std::uint32_t invHandle;
+    std::uint32_t formID;
+    std::uint32_t stackId;
+};
+
+struct MockContainerMenu
+{
+    MockService& service;
+    std::vector<MockEntry> playerInv;
+    std::vector<MockEntry> containerInv;
+
+    void UpdateList() {
+        Fill(service.player, playerInv);
+        Fill(service.container, containerInv);
+    }
+    static void Fill(MockInventory& a_inventory, std::vector<MockEntry>& a_entries) {
+        std::shared_lock locker{ a_inventory.lock };
+        a_entries.clear();
+        for (const auto& item : a_inventory.items) {
+            for (std::uint32_t i = 0; i < item.stacks.size(); ++i)
+                a_entries.push_back({ item.handle, item.formID, i });
+        }
+    }
+};
+
+// --- Test state ---
+
+constexpr std::uint32_t FORM_COUNT = 24;
+constexpr std::uint32_t STACKS_PER_FORM = 4;
+constexpr std::uint32_t FIRST_FORM_ID = 0x1000;
+
+// Two complete policies the writer alternates between; favorites stay locked in both
+constexpr LockPolicy POLICY_A{ true, true, true, true, true, true };
+constexpr LockPolicy POLICY_B{ false, true, false, true, true, false };
+
+static bool SamePolicy(const LockPolicy& a_lhs, const LockPolicy& a_rhs) {
+    return a_lhs.equipped == a_rhs.equipped && a_lhs.favorites == a_rhs.favorites && a_lhs.scrap == a_rhs.scrap &&
+           a_lhs.bidirectional == a_rhs.bidirectional && a_lhs.takeAll == a_rhs.takeAll && a_lhs.drop == a_rhs.drop;
+}
+
+struct Counters
+{
+    std::atomic<std::uint64_t> transfers{ 0 };
+    std::atomic<std::uint64_t> blocked{ 0 };
+    std::atomic<std::uint64_t> takeAlls{ 0 };
+    std::atomic<std::uint64_t> queries{ 0 };
+    std::atomic<std::uint64_t> checked{ 0 };
+    std::atomic<std::uint64_t> toggles{ 0 };
+    std::atomic<std::uint64_t> violations{ 0 };
+};
+
+static void Fail(Counters& a_counters, std::string_view a_what) {
+    if (a_counters.violations.fetch_add(1) < 10)
+        std::printf("VIOLATION: %.*s\n", static_cast<int>(a_what.size()), a_what.data());
+}
+
+// Pinned stacks: stack 0 favorite, stack 1 plain. Volatile stacks start clear and get toggled
+static void FillPlayer(MockInventory& a_player) {
+    for (std::uint32_t form = 0; form < FORM_COUNT; ++form) {
+        auto& item = a_player.Add(FIRST_FORM_ID + form);
+        for (std::uint32_t i = 0; i < STACKS_PER_FORM; ++i) {
+            MockStack stack;
+            if (i < 2) {
+                stack.pinned = true;
+                stack.favorite = (i == 0);
+            }
+            item.stacks.push_back(stack);
+        }
+    }
+}
+
+// Companion gear: every other form has one equipped stack in the container. Spare stacks of the
+// same forms arrive through player transfers and must still be taken by Take All
+static void FillContainer(MockInventory& a_container) {
+    for (std::uint32_t form = 0; form < FORM_COUNT; form += 2)
+        a_container.Add(FIRST_FORM_ID + form).stacks.push_back(MockStack{ true, false, false });
+}
+
+static std::size_t CountPinnedFavorites(MockInventory& a_inventory) {
+    std::shared_lock locker{ a_inventory.lock };
+    std::size_t count = 0;
+    for (const auto& item : a_inventory.items)
+        count += std::count_if(item.stacks.begin(), item.stacks.end(), [](const MockStack& a_stack) { return a_stack.pinned && a_stack.favorite; });
+    return count;
+}
+
+// --- Threads ---
+
+// MyContDoItemTransfer: judge the entry, forward only if it is not protected
+static void DoItemTransfer(MockService& a_service, MockContainerMenu& a_menu, std::size_t a_index, bool a_fromContainer, Counters& a_counters) {
+    const auto policy = GetLockPolicy();
+    const auto& list = a_fromContainer ? a_menu.containerInv : a_menu.playerInv;
+    if (a_index >= list.size())
+        return;
+    const auto entry = list[a_index];
+    if (policy.LocksAnything() && (!a_fromContainer || policy.bidirectional)) {
+        const auto facts = a_fromContainer ? a_service.GetContainerFacts(entry.formID, entry.stackId) : a_service.GetPlayerFacts(entry.formID, entry.stackId);
+        if (facts.IsProtected(policy)) {
+            a_counters.blocked.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    const auto moved = a_service.MoveStack(a_fromContainer, entry.formID, entry.stackId);
+    if (moved && !a_fromContainer && moved->pinned && moved->favorite)
+        Fail(a_counters, "pinned favorite stack left the player");
+    a_counters.transfers.fetch_add(1, std::memory_order_relaxed);
+}
+
+// MyTakeAllItems: locked stacks judged up front in the menu arena, then backwards with index re-checks
+static void TakeAll(MockService& a_service, MockContainerMenu& a_menu, Counters& a_counters) {
+    const auto entryCount = a_menu.containerInv.size();
+    const auto policy = GetLockPolicy();
+    const bool judge = policy.LocksAnything() && policy.bidirectional;
+    LockedStacks lockedStacks{ MenuArena::GetSingleton().Begin(entryCount), judge ? entryCount : 0 };
+    const auto isLocked = [&](const MockEntry& a_entry) { return a_service.GetContainerFacts(a_entry.formID, a_entry.stackId).IsProtected(policy); };
+    if (judge) {
+        for (const auto& entry : a_menu.containerInv) {
+            if (isLocked(entry))
+                lockedStacks.Insert(entry.invHandle, entry.stackId);
+        }
+    }
+    for (int i = static_cast<int>(entryCount) - 1; i >= 0; --i) {
+        if (static_cast<std::size_t>(i) >= a_menu.containerInv.size())
+            continue;
+        const auto& entry = a_menu.containerInv[i];
+        if (lockedStacks.Contains(entry.invHandle, entry.stackId) && isLocked(entry))
+            continue;
+        DoItemTransfer(a_service, a_menu, static_cast<std::size_t>(i), true, a_counters);
+        a_menu.UpdateList();
+    }
+    // Only the UI thread moves container stacks, so whatever is left must have been locked.
+    // The writer may have switched policies meanwhile, POLICY_A locks a superset of POLICY_B
+    if (judge) {
+        std::shared_lock locker{ a_service.container.lock };
+        for (const auto& item : a_service.container.items) {
+            for (const auto& stack : item.stacks) {
+                if (!Facts{ stack.equipped, stack.favorite }.IsProtected(POLICY_A))
+                    Fail(a_counters, "Take All left an unlocked stack behind");
+            }
+        }
+    }
+    a_counters.takeAlls.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void UiThread(MockService& a_service, const std::atomic<bool>& a_stop, Counters& a_counters) {
+    MockContainerMenu menu{ a_service, {}, {} };
+    std::mt19937 rng{ 1 };
+    std::uint64_t iteration = 0;
+    while (!a_stop.load(std::memory_order_relaxed)) {
+        menu.UpdateList();
+        if (!menu.playerInv.empty())
+            DoItemTransfer(a_service, menu, rng() % menu.playerInv.size(), false, a_counters);
+        if (++iteration % 8 == 0) {
+            menu.UpdateList();
+            TakeAll(a_service, menu, a_counters);
+        }
+        // Menu closed
+        if (iteration % 64 == 0)
+            MenuArena::GetSingleton().Release();
+    }
+    MenuArena::GetSingleton().Release();
+}
+
+static void ReaderThread(MockService& a_service, const std::atomic<bool>& a_stop, Counters& a_counters, unsigned a_seed) {
+    std::mt19937 rng{ a_seed };
+    while (!a_stop.load(std::memory_order_relaxed)) {
+        const auto policy = GetLockPolicy();
+        if (!SamePolicy(policy, POLICY_A) && !SamePolicy(policy, POLICY_B))
+            Fail(a_counters, "torn LockPolicy snapshot");
+        const auto formID = FIRST_FORM_ID + static_cast<std::uint32_t>(rng() % FORM_COUNT);
+        const auto stackId = static_cast<std::uint32_t>(rng() % STACKS_PER_FORM);
+        const auto before = a_service.player.version.load(std::memory_order_acquire);
+        const auto facts = a_service.GetPlayerFacts(formID, stackId);
+        a_counters.queries.fetch_add(1, std::memory_order_relaxed);
+        std::shared_lock locker{ a_service.player.lock };
+        // Only judge queries the inventory did not change under
+        if (a_service.player.version.load(std::memory_order_acquire) != before)
+            continue;
+        const auto truth = a_service.player.GetFacts(formID, stackId);
+        if (!truth)
+            continue;
+        if (facts.equipped != truth->equipped || facts.favorite != truth->favorite || facts.IsProtected(policy) != truth->IsProtected(policy))
+            Fail(a_counters, "cached decision differs from the inventory");
+        a_counters.checked.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void WriterThread(MockService& a_service, const std::atomic<bool>& a_stop, Counters& a_counters) {
+    std::mt19937 rng{ 7 };
+    std::uint64_t iteration = 0;
+    while (!a_stop.load(std::memory_order_relaxed)) {
+        // Config reload
+        SetLockPolicy(++iteration % 2 ? POLICY_B : POLICY_A);
+        // Equip or favorite toggle on a volatile player stack, then clear like the equip sink / Pip-Boy close
+        {
+            std::unique_lock locker{ a_service.player.lock };
+            auto& item = a_service.player.items[rng() % a_service.player.items.size()];
+            if (!item.stacks.empty()) {
+                auto& stack = item.stacks[rng() % item.stacks.size()];
+                if (!stack.pinned) {
+                    if (rng() % 2)
+                        stack.equipped = !stack.equipped;
+                    else
+                        stack.favorite = !stack.favorite;
+                    a_service.cache.Clear();
+                    a_service.player.version.fetch_add(1, std::memory_order_release);
+                    a_counters.toggles.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    const unsigned readers = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 4u;
+
+    MockService service;
+    FillPlayer(service.player);
+    FillContainer(service.container);
+    service.cache.Reserve(FORM_COUNT * STACKS_PER_FORM);
+    SetLockPolicy(POLICY_A);
+    const auto pinnedFavorites = CountPinnedFavorites(service.player);
+
+    Counters counters;
+    std::atomic<bool> stop{ false };
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.emplace_back(UiThread, std::ref(service), std::cref(stop), std::ref(counters));
+    threads.emplace_back(WriterThread, std::ref(service), std::cref(stop), std::ref(counters));
+    for (unsigned i = 0; i < readers; ++i)
+        threads.emplace_back(ReaderThread, std::ref(service), std::cref(stop), std::ref(counters), 100 + i);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads)
+        thread.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Quiescent: every cached fact must match the inventory, pinned favorites never left
+    for (const auto& item : service.player.items) {
+        for (std::uint32_t i = 0; i < item.stacks.size(); ++i) {
+            const auto facts = service.GetPlayerFacts(item.formID, i);
+            if (facts.equipped != item.stacks[i].equipped || facts.favorite != item.stacks[i].favorite)
+                Fail(counters, "stale cache entry after the run");
+        }
+    }
+    if (CountPinnedFavorites(service.player) != pinnedFavorites)
+        Fail(counters, "pinned favorite count changed");
+
+    const auto rate = [&](const std::atomic<std::uint64_t>& a_count) { return static_cast<double>(a_count.load()) / elapsed.count(); };
+    const auto hits = service.cache.GetHits();
+    const auto misses = service.cache.GetMisses();
+    std::printf("Stress: %.2fs, %u readers | transfers %.0f/s (blocked %llu) | take all %.0f/s | queries %.0f/s (checked %llu) | toggles %.0f/s | "
+                "cache hit rate %.1f%% | arena high-water %zu bytes | violations %llu\n",
+        elapsed.count(), readers, rate(counters.transfers), static_cast<unsigned long long>(counters.blocked.load()), rate(counters.takeAlls),
+        rate(counters.queries), static_cast<unsigned long long>(counters.checked.load()), rate(counters.toggles),
+        hits + misses ? 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0, MenuArena::GetSingleton().GetHighWater(),
+        static_cast<unsigned long long>(counters.violations.load()));
+    return counters.violations.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,28 @@
+#pragma once
+// Portable stand-in for Global.h: the debug flag and REX logging on stdout
+#include <PCH.h>
+#include <LockPolicy.h>
+#include <sstream>
+
+extern std::atomic<bool> DEBUGGING;
+
+namespace REX
+{
+    // Replaces each {} (format specs are ignored) with the next argument. Enough for the shared
+    // sources' log lines, and works on standard libraries that do not ship <format> yet
+    template <class... Args> void INFO(std::string_view a_fmt, Args &&...a_args)
+    {
+        std::ostringstream out;
+        const auto next = [&](const auto& a_arg) {
+            const auto open = a_fmt.find('{');
+            const auto close = open == std::string_view::npos ? open : a_fmt.find('}', open);
+            if (close == std::string_view::npos)
+                return;
+            out << a_fmt.substr(0, open) << a_arg;
+            a_fmt.remove_prefix(close + 1);
+        };
+        (next(a_args), ...);
+        out << a_fmt;
+        std::puts(out.str().c_str());
+    }
+} // namespace REX